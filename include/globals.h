@@ -54,6 +54,25 @@ char* customChannelTag = "596";
 int customTrendInterval = 0;
 int customRealtimeInterval = 0;
 
+/*
+ * Reconnect settings. When IoT Hub stops confirming messages, new messages are held
+ * back for a random delay within a backoff window that starts at the initial delay
+ * and doubles on each further attempt, up to the maximum delay (milliseconds), while
+ * the SDK keeps reconnecting and retrying the messages already queued. The failure
+ * threshold is the number of consecutive checks (one per real-time message) without
+ * a confirmation before backing off, and max attempts limits the number of backoffs
+ * per outage before the application gives up.
+ *
+ * If 0, the default values (i.e., 1 second initial delay, 60 second maximum delay,
+ * 6 checks, unlimited attempts) will be used.
+ *
+ * DEFAULT: 0
+ */
+int customReconnectInitialDelay = 0;
+int customReconnectMaxDelay = 0;
+int customReconnectFailureThreshold = 0;
+int customReconnectMaxAttempts = 0;
+
 /*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
 /*  END SECTION |                      USER-MODIFIABLE VARIABLES                | END SECTION  */
 /***********************************************************************************************/
@@ -80,6 +99,17 @@ int customRealtimeInterval = 0;
 int defaultTrendInterval = 10;
 int defaultRealtimeInterval = 5;
 
+/**
+ *  Reconnect-related variables. Delays are in milliseconds; a max attempts
+ *  value of 0 means reconnect attempts are unlimited.
+ *
+ * !DO NOT MODIFY!
+ */
+int defaultReconnectInitialDelay = 1000;
+int defaultReconnectMaxDelay = 60000;
+int defaultReconnectFailureThreshold = 6;
+int defaultReconnectMaxAttempts = 0;
+
 /*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
 /*                     (DO NOT EDIT) SAMPLE DATA (DO NOT EDIT)                                 */
 /***********************************************************************************************/
@@ -125,6 +155,13 @@ int maxDevicesSupported = 1; /* This is a single device (low-cost), stand-alone
 int trendInterval = 0;
 int realtimeInterval = 0;
 
+int reconnectInitialDelay = 0;
+int reconnectMaxDelay = 0;
+int reconnectFailureThreshold = 0;
+int reconnectMaxAttempts = 0;
+int reconnectBackoffCount = 0;     /* total backoffs since the application started */
+unsigned int reconnectSeed = 0;    /* private rand_r() state so backoff jitter doesn't disturb the sample data */
+
 int numConnStrings = 0;
 int numDeviceUUIDs = 0;
 int numDeviceProfileUUIDs = 0;
@@ -149,6 +186,8 @@ const char* channelTag;
 
 
 void setGlobals();
+unsigned int getReconnectDelay(int attempt);
+void holdBackSends(int attempt, long queuedMessages);
 
 /* ########################################################################################### */
 /*                                                                                             */
@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200112L /* rand_r */
+
 #include <unistd.h>
 #include <math.h>
 #include <stdio.h>
@@ -36,6 +38,11 @@ int main(int argc, char** argv) {
     int status = 0;
     IOT_DEVICE_HANDLE deviceHandle = iot_open(&connectionOptions, &status);
 
+    if (deviceHandle == NULL) {
+        printf("\n\n >> --------- Unable to Connect to IoT Hub (status: %d). Terminating Application --------- << \n\n", status);
+        return (EXIT_FAILURE);
+    }
+
     /** EXAMPLE: PUBLISH DEVICE \ DEVICE TREE
      * Now that we've established connectivity, let's prepare and publish the
      * sample or user-defined via IoT Hub device handle, as defined in globals.h,
@@ -194,6 +201,20 @@ int main(int argc, char** argv) {
 
     printf("\n\n >> --------- Prepare and Send Device Channel Real-time Data from Device --------- << \n\n");
 
+    /** The library keeps the connection status at IOT_OPENED while IoT Hub is
+     * unreachable and only queues the messages, so an outage is detected from
+     * the counters reported by iot_getStatus: a check is unhealthy when the last
+     * confirmation failed (IOT_UNKNOWN) or when messages are outstanding and no
+     * new confirmation has arrived since the previous check.
+     *
+     * The transport already re-establishes its connection on every failed request
+     * and keeps the queued messages, so an outage leaves the handle open and only
+     * holds back new messages with a jittered, growing backoff.
+     */
+    long lastConfirmed = 0;
+    int unhealthyChecks = 0;
+    int outageAttempts = 0;
+    time_t outageStart = 0;
 	
     int i;
    for  (i=1;  i<100;  i=i+1)
@@ -230,6 +251,59 @@ int main(int argc, char** argv) {
     printf("\n\n >> --------- PUBLISH DEVICE CHANNEL\\POINT REAL-TIME DATA END --------- << \n\n");
     
     sleep(5);
+
+    /* Check the connection once the message has had time to be confirmed */
+    IOT_CONNECTION_STATUS connectionStatus;
+    if (!iot_getStatus(deviceHandle, &connectionStatus) || connectionStatus.connectionStatus == IOT_CLOSING) {
+
+        /** The handle itself is no longer usable, so it has to be replaced.
+         * Not retried: iot_open fails only on a malformed connection string or out of
+         * memory, which repeat every time, or when the message thread can't be created,
+         * which leaves the connection registered so every later open reports a duplicate.
+         */
+        printf("\n\n >> IoT Hub Connection Is No Longer Usable, Reopening ");
+        deviceHandle = iot_open(&connectionOptions, &status);
+        if (deviceHandle == NULL) {
+            printf("\n\n >> --------- Unable to Reopen IoT Hub Connection (status: %d). Terminating Application --------- << \n\n", status);
+            return (EXIT_FAILURE);
+        }
+
+        /* the counters start over with the new connection */
+        lastConfirmed = 0;
+        unhealthyChecks = 0;
+
+    } else if (connectionStatus.msgConfirmed > lastConfirmed) {
+
+        if (outageAttempts > 0) {
+            printf("\n\n >> Recovered IoT Hub Connection in %.0f second(s) after %d backoff(s) (total backoffs: %d) ",
+                    difftime(time(NULL), outageStart), outageAttempts, reconnectBackoffCount);
+        }
+
+        lastConfirmed = connectionStatus.msgConfirmed;
+        unhealthyChecks = 0;
+        outageAttempts = 0;
+
+    } else if (connectionStatus.connectionStatus == IOT_UNKNOWN || connectionStatus.msgOutbound > connectionStatus.msgConfirmed) {
+
+        if (unhealthyChecks == 0 && outageAttempts == 0) {
+            outageStart = time(NULL);
+        }
+
+        /* once an outage is detected, every unconfirmed probe message backs off further */
+        if (++unhealthyChecks >= reconnectFailureThreshold || outageAttempts > 0) {
+
+            if (reconnectMaxAttempts > 0 && outageAttempts >= reconnectMaxAttempts) {
+                printf("\n\n >> --------- Unable to Recover IoT Hub Connection After %d Backoff(s). Terminating Application --------- << \n\n", outageAttempts);
+                iot_close(deviceHandle);
+                return (EXIT_FAILURE);
+            }
+
+            outageAttempts++;
+            reconnectBackoffCount++;
+
+            holdBackSends(outageAttempts, connectionStatus.msgOutbound - connectionStatus.msgConfirmed);
+        }
+    }
 }
 
 
@@ -269,6 +343,11 @@ void setGlobals() {
         trendInterval = defaultTrendInterval;
         realtimeInterval = defaultRealtimeInterval;
 
+        reconnectInitialDelay = defaultReconnectInitialDelay;
+        reconnectMaxDelay = defaultReconnectMaxDelay;
+        reconnectFailureThreshold = defaultReconnectFailureThreshold;
+        reconnectMaxAttempts = defaultReconnectMaxAttempts;
+
     } else { /*  use custom, user-defined data  */
 
         printf("\n\n >> --------- Initializing Global App Variables (User-Defined)  --------- << \n\n");
@@ -298,8 +377,53 @@ void setGlobals() {
             printf("\n\n >> Setting Custom Real-time Interval");
             realtimeInterval = customRealtimeInterval;
         }
+
+        if (!customReconnectInitialDelay) {
+            printf("\n\n >> Using Default Reconnect Initial Delay");
+            reconnectInitialDelay = defaultReconnectInitialDelay;
+        } else {
+            printf("\n\n >> Setting Custom Reconnect Initial Delay");
+            reconnectInitialDelay = customReconnectInitialDelay;
+        }
+
+        if (!customReconnectMaxDelay) {
+            printf("\n\n >> Using Default Reconnect Maximum Delay");
+            reconnectMaxDelay = defaultReconnectMaxDelay;
+        } else {
+            printf("\n\n >> Setting Custom Reconnect Maximum Delay");
+            reconnectMaxDelay = customReconnectMaxDelay;
+        }
+
+        if (!customReconnectFailureThreshold) {
+            printf("\n\n >> Using Default Reconnect Failure Threshold");
+            reconnectFailureThreshold = defaultReconnectFailureThreshold;
+        } else {
+            printf("\n\n >> Setting Custom Reconnect Failure Threshold");
+            reconnectFailureThreshold = customReconnectFailureThreshold;
+        }
+
+        if (!customReconnectMaxAttempts) {
+            printf("\n\n >> Using Default Reconnect Maximum Attempts");
+            reconnectMaxAttempts = defaultReconnectMaxAttempts;
+        } else {
+            printf("\n\n >> Setting Custom Reconnect Maximum Attempts");
+            reconnectMaxAttempts = customReconnectMaxAttempts;
+        }
     }
 
+    /** Seed the backoff jitter. Gateways that power up together after a site outage can
+     * start in the same second with the same PID, so the device identity is mixed in too.
+     */
+    unsigned int seed = (unsigned int) time(NULL) ^ ((unsigned int) getpid() << 16);
+    const char *c;
+    for (c = deviceUUID; c != NULL && *c != '\0'; c++) {
+        seed = seed * 31 + (unsigned char) *c;
+    }
+    for (c = deviceMAC; c != NULL && *c != '\0'; c++) {
+        seed = seed * 31 + (unsigned char) *c;
+    }
+    reconnectSeed = seed;
+
     globalsInitialized = true;
 
     printf("\n\n >> Using IoT Hub Connection String: %s ", connectionString);
@@ -313,3 +437,33 @@ void setGlobals() {
     printf("\n\n >> --------- INITIALIZED GLOBAL VARIABLES --------- <<\n\n");
 }
 
+
+unsigned int getReconnectDelay(int attempt) {
+
+    /* the backoff window doubles with each attempt of an outage, up to the maximum delay */
+    unsigned int window = (unsigned int) reconnectInitialDelay;
+    int i;
+
+    for (i = 1; i < attempt && window < (unsigned int) reconnectMaxDelay; i++) {
+        window *= 2;
+    }
+
+    if (window > (unsigned int) reconnectMaxDelay) {
+        window = (unsigned int) reconnectMaxDelay;
+    }
+
+    /* "full jitter": wait a random amount within the window */
+    return (unsigned int) rand_r(&reconnectSeed) % (window + 1);
+}
+
+
+void holdBackSends(int attempt, long queuedMessages) {
+
+    unsigned int delay = getReconnectDelay(attempt);
+
+    printf("\n\n >> No Confirmations From IoT Hub, Holding Back New Messages for %u ms (backoff %d, %ld message(s) queued) ",
+            delay, attempt, queuedMessages);
+
+    /* the message thread keeps retrying the queued messages meanwhile */
+    ThreadAPI_Sleep(delay);
+}